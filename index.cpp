@@ -3,9 +3,14 @@
 #include <sstream>
 #include <string>
 #include <vector>
+#include <set>
 #include <algorithm>
 #include <cctype>
 #include <cstring>
+#include <cstdio>
+#include <cstdlib>
+#include <climits>
+#include <cerrno>
 
 #ifdef _WIN32
     #include <windows.h>
@@ -79,12 +84,70 @@ std::vector<std::string> list_txt_files(const std::string& dir) {
     return files;
 }
 
-int main() {
+std::string shard_file_name(int shard) {
+    return "inverted_index_" + std::to_string(shard) + ".bin";
+}
+
+bool write_inverted_index(const std::string& filename, const std::vector<TermRecord>& inverted_index) {
+    std::ofstream inv_out(filename, std::ios::binary);
+    if (!inv_out.is_open()) {
+        std::cerr << "Не удалось создать " << filename << std::endl;
+        return false;
+    }
+
+    int num_terms = static_cast<int>(inverted_index.size());
+    inv_out.write(reinterpret_cast<const char*>(&num_terms), sizeof(int));
+
+    for (const TermRecord& tr : inverted_index) {
+        int len = static_cast<int>(tr.term.length());
+        inv_out.write(reinterpret_cast<const char*>(&len), sizeof(int));
+        inv_out.write(tr.term.c_str(), len);
+
+        int num_docs = static_cast<int>(tr.doc_ids.size());
+        inv_out.write(reinterpret_cast<const char*>(&num_docs), sizeof(int));
+        for (int id : tr.doc_ids) {
+            inv_out.write(reinterpret_cast<const char*>(&id), sizeof(int));
+        }
+    }
+    inv_out.close();
+    if (!inv_out) {
+        std::cerr << "Ошибка записи " << filename << std::endl;
+        return false;
+    }
+    return true;
+}
+
+// Удаляет inverted_index_<from>.bin, inverted_index_<from + 1>.bin, ...
+// до первого отсутствующего файла.
+void remove_shard_files(int from) {
+    int k = from;
+    while (std::remove(shard_file_name(k).c_str()) == 0) {
+        ++k;
+    }
+}
+
+int main(int argc, char* argv[]) {
     const std::string corpus_dir = "corpus_en";
     const std::string inverted_index_file = "inverted_index.bin";
     const std::string forward_index_file = "forward_index.bin";
+    const std::string shards_file = "index_shards.bin";
+
+    int num_shards = 1;
+    if (argc > 2) {
+        std::cerr << "Использование: " << argv[0] << " [число_шардов]\n";
+        return 1;
+    }
+    if (argc == 2) {
+        char* end = nullptr;
+        errno = 0;
+        long value = std::strtol(argv[1], &end, 10);
+        if (!std::isdigit(static_cast<unsigned char>(argv[1][0])) || *end != '\0' || errno == ERANGE || value < 1 || value > INT_MAX) {
+            std::cerr << "Число шардов должно быть положительным\n";
+            return 1;
+        }
+        num_shards = static_cast<int>(value);
+    }
 
-    std::vector<TermRecord> inverted_index;
     std::vector<DocRecord> forward_index;
 
     std::vector<std::string> filenames = list_txt_files(corpus_dir);
@@ -96,10 +159,31 @@ int main() {
     size_t num_files = filenames.size();
     std::cout << "Найдено " << num_files << " файлов\n";
 
-    for (size_t doc_id = 0; doc_id < num_files; ++doc_id) {
-        const std::string& filename = filenames[doc_id];
+    if (num_shards > static_cast<int>(num_files)) {
+        num_shards = static_cast<int>(num_files);
+    }
+
+    // Файлы делятся на шарды поровну: шард k получает файлы из
+    // [file_begin[k], file_begin[k + 1]). Нечитаемые файлы пропускаются и не
+    // получают doc_id, поэтому границы шардов по doc_id (shard_begin)
+    // фиксируются по мере индексации.
+    std::vector<size_t> file_begin(num_shards + 1);
+    for (int k = 0; k <= num_shards; ++k) {
+        file_begin[k] = num_files * k / num_shards;
+    }
+    std::vector<int> shard_begin(num_shards + 1, 0);
+    std::vector<std::vector<TermRecord>> shards(num_shards);
+    int shard = 0;
+
+    for (size_t file_idx = 0; file_idx < num_files; ++file_idx) {
+        const std::string& filename = filenames[file_idx];
         std::string filepath = corpus_dir + "/" + filename;
 
+        while (file_idx >= file_begin[shard + 1]) {
+            ++shard;
+            shard_begin[shard] = static_cast<int>(forward_index.size());
+        }
+
         std::ifstream file(filepath, std::ios::binary);
         if (!file.is_open()) {
             std::cerr << "Не удалось открыть: " << filepath << std::endl;
@@ -113,18 +197,21 @@ int main() {
 
         std::vector<std::string> tokens = tokenize(content);
 
+        int doc_id = static_cast<int>(forward_index.size());
         DocRecord doc_rec;
-        doc_rec.doc_id = static_cast<int>(doc_id);
+        doc_rec.doc_id = doc_id;
         size_t dot_pos = filename.find('.');
         doc_rec.title = (dot_pos != std::string::npos) ? filename.substr(0, dot_pos) : filename;
         doc_rec.url = "https://en.wikipedia.org/wiki/" + doc_rec.title;
         forward_index.push_back(doc_rec);
 
+        std::vector<TermRecord>& inverted_index = shards[shard];
+
         for (const std::string& token : tokens) {
             bool found = false;
             for (TermRecord& term_rec : inverted_index) {
                 if (term_rec.term == token) {
-                    term_rec.doc_ids.push_back(static_cast<int>(doc_id));
+                    term_rec.doc_ids.push_back(doc_id);
                     found = true;
                     break;
                 }
@@ -132,39 +219,47 @@ int main() {
             if (!found) {
                 TermRecord new_term;
                 new_term.term = token;
-                new_term.doc_ids.push_back(static_cast<int>(doc_id));
+                new_term.doc_ids.push_back(doc_id);
                 inverted_index.push_back(new_term);
             }
         }
 
-        if ((doc_id + 1) % 1000 == 0) {
-            std::cout << "Обработано: " << (doc_id + 1) << " документов\n";
+        if ((file_idx + 1) % 1000 == 0) {
+            std::cout << "Обработано: " << (file_idx + 1) << " документов\n";
         }
     }
-
-    std::sort(inverted_index.begin(), inverted_index.end(), compare_terms);
-
-    std::ofstream inv_out(inverted_index_file, std::ios::binary);
-    if (!inv_out.is_open()) {
-        std::cerr << "Не удалось создать " << inverted_index_file << std::endl;
-        return 1;
+    while (shard < num_shards) {
+        ++shard;
+        shard_begin[shard] = static_cast<int>(forward_index.size());
     }
 
-    int num_terms = static_cast<int>(inverted_index.size());
-    inv_out.write(reinterpret_cast<const char*>(&num_terms), sizeof(int));
-
-    for (const TermRecord& tr : inverted_index) {
-        int len = static_cast<int>(tr.term.length());
-        inv_out.write(reinterpret_cast<const char*>(&len), sizeof(int));
-        inv_out.write(tr.term.c_str(), len);
-
-        int num_docs = static_cast<int>(tr.doc_ids.size());
-        inv_out.write(reinterpret_cast<const char*>(&num_docs), sizeof(int));
-        for (int id : tr.doc_ids) {
-            inv_out.write(reinterpret_cast<const char*>(&id), sizeof(int));
+    std::set<std::string> vocabulary;
+    for (std::vector<TermRecord>& inverted_index : shards) {
+        std::sort(inverted_index.begin(), inverted_index.end(), compare_terms);
+        for (const TermRecord& tr : inverted_index) {
+            vocabulary.insert(tr.term);
+        }
+    }
+    int num_terms = static_cast<int>(vocabulary.size());
+
+    // Старая раскладка удаляется до записи новой, а манифест пишется
+    // последним: прерванная переиндексация не оставит на диске набор файлов,
+    // который search примет за корректный индекс.
+    std::remove(shards_file.c_str());
+    std::remove(inverted_index_file.c_str());
+    remove_shard_files(num_shards == 1 ? 0 : num_shards);
+
+    if (num_shards == 1) {
+        if (!write_inverted_index(inverted_index_file, shards[0])) {
+            return 1;
+        }
+    } else {
+        for (int k = 0; k < num_shards; ++k) {
+            if (!write_inverted_index(shard_file_name(k), shards[k])) {
+                return 1;
+            }
         }
     }
-    inv_out.close();
 
     std::ofstream fwd_out(forward_index_file, std::ios::binary);
     if (!fwd_out.is_open()) {
@@ -187,10 +282,33 @@ int main() {
         fwd_out.write(dr.url.c_str(), len_url);
     }
     fwd_out.close();
+    if (!fwd_out) {
+        std::cerr << "Ошибка записи " << forward_index_file << std::endl;
+        return 1;
+    }
+
+    if (num_shards > 1) {
+        std::ofstream shards_out(shards_file, std::ios::binary);
+        if (!shards_out.is_open()) {
+            std::cerr << "Не удалось создать " << shards_file << std::endl;
+            return 1;
+        }
+        shards_out.write(reinterpret_cast<const char*>(&num_shards), sizeof(int));
+        for (int k = 0; k < num_shards; ++k) {
+            shards_out.write(reinterpret_cast<const char*>(&shard_begin[k]), sizeof(int));
+            shards_out.write(reinterpret_cast<const char*>(&shard_begin[k + 1]), sizeof(int));
+        }
+        shards_out.close();
+        if (!shards_out) {
+            std::cerr << "Ошибка записи " << shards_file << std::endl;
+            return 1;
+        }
+    }
 
     std::cout << "\nИндексы построены успешно.\n";
     std::cout << "Документов: " << num_docs << "\n";
     std::cout << "Терминов: " << num_terms << "\n";
+    std::cout << "Шардов: " << num_shards << "\n";
 
     return 0;
 }
\ No newline at end of file
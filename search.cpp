@@ -7,6 +7,8 @@
 #include <algorithm>
 #include <cctype>
 #include <chrono>
+#include <functional>
+#include <thread>
 
 struct TermRecord {
     std::string term;
@@ -19,11 +21,17 @@ struct DocRecord {
     std::string url;
 };
 
+struct IndexShard {
+    std::vector<TermRecord> inverted_index;
+    int doc_begin;
+    int doc_end;
+};
+
 std::vector<std::string> tokenize_query(const std::string& query);
-std::vector<int> evaluate_expression(const std::vector<std::string>& tokens, size_t& pos, const std::vector<TermRecord>& inverted_index, int total_docs);
-std::vector<int> evaluate_term(const std::vector<std::string>& tokens, size_t& pos, const std::vector<TermRecord>& inverted_index, int total_docs);
-std::vector<int> evaluate_factor(const std::vector<std::string>& tokens, size_t& pos, const std::vector<TermRecord>& inverted_index, int total_docs);
-std::vector<int> execute_search(const std::string& query, const std::vector<TermRecord>& inverted_index, const std::vector<DocRecord>& forward_index);
+std::vector<int> evaluate_expression(const std::vector<std::string>& tokens, size_t& pos, const std::vector<TermRecord>& inverted_index, int doc_begin, int doc_end);
+std::vector<int> evaluate_term(const std::vector<std::string>& tokens, size_t& pos, const std::vector<TermRecord>& inverted_index, int doc_begin, int doc_end);
+std::vector<int> evaluate_factor(const std::vector<std::string>& tokens, size_t& pos, const std::vector<TermRecord>& inverted_index, int doc_begin, int doc_end);
+std::vector<int> execute_search(const std::string& query, const std::vector<IndexShard>& shards);
 
 char to_lower(char c) {
     if (c >= 'A' && c <= 'Z') {
@@ -119,10 +127,10 @@ std::vector<int> or_op(const std::vector<int>& a, const std::vector<int>& b) {
     return result;
 }
 
-std::vector<int> not_op(const std::vector<int>& a, int total_docs) {
+std::vector<int> not_op(const std::vector<int>& a, int doc_begin, int doc_end) {
     std::vector<int> result;
     std::set<int> excluded(a.begin(), a.end());
-    for (int i = 0; i < total_docs; ++i) {
+    for (int i = doc_begin; i < doc_end; ++i) {
         if (excluded.find(i) == excluded.end()) {
             result.push_back(i);
         }
@@ -130,40 +138,40 @@ std::vector<int> not_op(const std::vector<int>& a, int total_docs) {
     return result;
 }
 
-std::vector<int> evaluate_expression(const std::vector<std::string>& tokens, size_t& pos, const std::vector<TermRecord>& inverted_index, int total_docs) {
-    std::vector<int> left = evaluate_term(tokens, pos, inverted_index, total_docs);
+std::vector<int> evaluate_expression(const std::vector<std::string>& tokens, size_t& pos, const std::vector<TermRecord>& inverted_index, int doc_begin, int doc_end) {
+    std::vector<int> left = evaluate_term(tokens, pos, inverted_index, doc_begin, doc_end);
     while (pos < tokens.size() && tokens[pos] == "||") {
         ++pos;
-        std::vector<int> right = evaluate_term(tokens, pos, inverted_index, total_docs);
+        std::vector<int> right = evaluate_term(tokens, pos, inverted_index, doc_begin, doc_end);
         left = or_op(left, right);
     }
     return left;
 }
 
-std::vector<int> evaluate_term(const std::vector<std::string>& tokens, size_t& pos, const std::vector<TermRecord>& inverted_index, int total_docs) {
-    std::vector<int> left = evaluate_factor(tokens, pos, inverted_index, total_docs);
+std::vector<int> evaluate_term(const std::vector<std::string>& tokens, size_t& pos, const std::vector<TermRecord>& inverted_index, int doc_begin, int doc_end) {
+    std::vector<int> left = evaluate_factor(tokens, pos, inverted_index, doc_begin, doc_end);
     while (pos < tokens.size() && (tokens[pos] == "&&" || tokens[pos] == " ")) {
         ++pos;
-        std::vector<int> right = evaluate_factor(tokens, pos, inverted_index, total_docs);
+        std::vector<int> right = evaluate_factor(tokens, pos, inverted_index, doc_begin, doc_end);
         left = and_op(left, right);
     }
     return left;
 }
 
-std::vector<int> evaluate_factor(const std::vector<std::string>& tokens, size_t& pos, const std::vector<TermRecord>& inverted_index, int total_docs) {
+std::vector<int> evaluate_factor(const std::vector<std::string>& tokens, size_t& pos, const std::vector<TermRecord>& inverted_index, int doc_begin, int doc_end) {
     if (pos >= tokens.size()) {
         return {};
     }
 
     if (tokens[pos] == "!") {
         ++pos;
-        std::vector<int> operand = evaluate_factor(tokens, pos, inverted_index, total_docs);
-        return not_op(operand, total_docs);
+        std::vector<int> operand = evaluate_factor(tokens, pos, inverted_index, doc_begin, doc_end);
+        return not_op(operand, doc_begin, doc_end);
     }
 
     if (tokens[pos] == "(") {
         ++pos;
-        std::vector<int> result = evaluate_expression(tokens, pos, inverted_index, total_docs);
+        std::vector<int> result = evaluate_expression(tokens, pos, inverted_index, doc_begin, doc_end);
         if (pos < tokens.size() && tokens[pos] == ")") {
             ++pos;
         }
@@ -175,33 +183,47 @@ std::vector<int> evaluate_factor(const std::vector<std::string>& tokens, size_t&
     return get_doc_ids(term, inverted_index);
 }
 
-std::vector<TermRecord> load_inverted_index(const std::string& filename) {
-    std::vector<TermRecord> inverted_index;
+std::string shard_file_name(int shard) {
+    return "inverted_index_" + std::to_string(shard) + ".bin";
+}
+
+bool load_inverted_index(const std::string& filename, std::vector<TermRecord>& inverted_index) {
     std::ifstream file(filename, std::ios::binary);
     if (!file.is_open()) {
-        std::cerr << "Ошибка: не удаётся открыть " << filename << "\n";
-        return inverted_index;
+        return false;
     }
 
     int num_terms;
     file.read(reinterpret_cast<char*>(&num_terms), sizeof(int));
+    if (!file || num_terms < 0) {
+        return false;
+    }
 
     for (int i = 0; i < num_terms; ++i) {
         int len;
         file.read(reinterpret_cast<char*>(&len), sizeof(int));
+        if (!file || len < 0) {
+            return false;
+        }
         std::string term(len, '\0');
         file.read(&term[0], len);
 
         int num_docs;
         file.read(reinterpret_cast<char*>(&num_docs), sizeof(int));
+        if (!file || num_docs < 0) {
+            return false;
+        }
         std::vector<int> doc_ids(num_docs);
         for (int j = 0; j < num_docs; ++j) {
             file.read(reinterpret_cast<char*>(&doc_ids[j]), sizeof(int));
         }
+        if (!file) {
+            return false;
+        }
 
         inverted_index.push_back({term, doc_ids});
     }
-    return inverted_index;
+    return true;
 }
 
 std::vector<DocRecord> load_forward_index(const std::string& filename) {
@@ -234,11 +256,106 @@ std::vector<DocRecord> load_forward_index(const std::string& filename) {
     return forward_index;
 }
 
-std::vector<int> execute_search(const std::string& query, const std::vector<TermRecord>& inverted_index, const std::vector<DocRecord>& forward_index) {
+// Выполняет task(0) ... task(count - 1), используя не больше
+// hardware_concurrency() потоков; поток w берёт задачи w, w + W, w + 2W, ...
+void run_parallel(size_t count, const std::function<void(size_t)>& task) {
+    if (count == 0) {
+        return;
+    }
+    size_t num_workers = std::max<size_t>(1, std::thread::hardware_concurrency());
+    num_workers = std::min(num_workers, count);
+
+    std::vector<std::thread> workers;
+    for (size_t w = 1; w < num_workers; ++w) {
+        workers.emplace_back([&task, count, num_workers, w]() {
+            for (size_t k = w; k < count; k += num_workers) {
+                task(k);
+            }
+        });
+    }
+    for (size_t k = 0; k < count; k += num_workers) {
+        task(k);
+    }
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+}
+
+std::vector<IndexShard> load_shards(const std::string& shards_file, const std::string& inverted_index_file, int total_docs) {
+    std::vector<IndexShard> shards;
+    std::ifstream file(shards_file, std::ios::binary);
+    if (!file.is_open()) {
+        IndexShard shard;
+        shard.doc_begin = 0;
+        shard.doc_end = total_docs;
+        if (!load_inverted_index(inverted_index_file, shard.inverted_index)) {
+            std::cerr << "Ошибка: не удаётся прочитать " << inverted_index_file << "\n";
+            return {};
+        }
+        shards.push_back(std::move(shard));
+        return shards;
+    }
+
+    int num_shards;
+    file.read(reinterpret_cast<char*>(&num_shards), sizeof(int));
+    if (!file || num_shards <= 0) {
+        std::cerr << "Ошибка: повреждён " << shards_file << "\n";
+        return {};
+    }
+
+    // Диапазоны шардов должны без пропусков покрывать [0, total_docs),
+    // иначе ! вернёт doc_id, которых нет в прямом индексе.
+    int expected_begin = 0;
+    for (int k = 0; k < num_shards; ++k) {
+        IndexShard shard;
+        file.read(reinterpret_cast<char*>(&shard.doc_begin), sizeof(int));
+        file.read(reinterpret_cast<char*>(&shard.doc_end), sizeof(int));
+        if (!file || shard.doc_begin != expected_begin || shard.doc_end < shard.doc_begin || shard.doc_end > total_docs) {
+            std::cerr << "Ошибка: повреждён " << shards_file << "\n";
+            return {};
+        }
+        expected_begin = shard.doc_end;
+        shards.push_back(std::move(shard));
+    }
+    if (expected_begin != total_docs) {
+        std::cerr << "Ошибка: " << shards_file << " не соответствует прямому индексу\n";
+        return {};
+    }
+
+    std::vector<char> loaded(shards.size(), 0);
+    run_parallel(shards.size(), [&shards, &loaded](size_t k) {
+        loaded[k] = load_inverted_index(shard_file_name(static_cast<int>(k)), shards[k].inverted_index);
+    });
+
+    bool ok = true;
+    for (size_t k = 0; k < shards.size(); ++k) {
+        if (!loaded[k]) {
+            std::cerr << "Ошибка: не удаётся прочитать " << shard_file_name(static_cast<int>(k)) << "\n";
+            ok = false;
+        }
+    }
+    if (!ok) {
+        return {};
+    }
+    return shards;
+}
+
+std::vector<int> execute_search(const std::string& query, const std::vector<IndexShard>& shards) {
     std::vector<std::string> tokens = tokenize_query(query);
-    size_t pos = 0;
-    int total_docs = static_cast<int>(forward_index.size());
-    return evaluate_expression(tokens, pos, inverted_index, total_docs);
+
+    // Шарды вычисляются параллельно; диапазоны doc_id шардов
+    // не пересекаются и упорядочены, поэтому результаты просто склеиваются.
+    std::vector<std::vector<int>> partial(shards.size());
+    run_parallel(shards.size(), [&tokens, &shards, &partial](size_t k) {
+        size_t pos = 0;
+        partial[k] = evaluate_expression(tokens, pos, shards[k].inverted_index, shards[k].doc_begin, shards[k].doc_end);
+    });
+
+    std::vector<int> result;
+    for (const std::vector<int>& part : partial) {
+        result.insert(result.end(), part.begin(), part.end());
+    }
+    return result;
 }
 
 void print_results_cli(const std::vector<int>& doc_ids, const std::vector<DocRecord>& forward_index) {
@@ -258,16 +375,16 @@ int main(int argc, char* argv[]) {
 
     std::string query = argv[1];
 
-    auto inverted_index = load_inverted_index("inverted_index.bin");
     auto forward_index = load_forward_index("forward_index.bin");
+    auto shards = load_shards("index_shards.bin", "inverted_index.bin", static_cast<int>(forward_index.size()));
 
-    if (inverted_index.empty() || forward_index.empty()) {
+    if (shards.empty() || forward_index.empty()) {
         std::cerr << "Не удалось загрузить индексы\n";
         return 1;
     }
 
     auto start = std::chrono::high_resolution_clock::now();
-    auto results = execute_search(query, inverted_index, forward_index);
+    auto results = execute_search(query, shards);
     auto end = std::chrono::high_resolution_clock::now();
 
     auto duration = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();